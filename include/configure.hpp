@@ -11,6 +11,13 @@ namespace seamcarve {
     */
    typedef struct {
       std::string image_path;
+
+      // Sequence mode, resizes every frame in input_dir into output_dir.
+      std::string input_dir;
+      std::string output_dir;
+      int width;
+      int height;
+      int band;
    } Config;
       
    /**
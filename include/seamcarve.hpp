@@ -4,10 +4,33 @@
 #include <QtCore/QSize>
 #include <QtGui/QImage>
 #include <QtGui/QPixmap>
+#include <vector>
 
 namespace seamcarve {
 
+   /**
+    * Seams removed while resizing a frame, in removal order.
+    * Each column seam holds one column per row, each row seam one row per column,
+    * measured in the image as it was when that seam was removed.
+    * Handing these to the next frame of a sequence lets its seam search stay
+    * within a small band around them instead of covering the whole image.
+    */
+   struct SeamHistory {
+      std::vector<std::vector<int>> column_seams;
+      std::vector<std::vector<int>> row_seams;
+
+      // Seams searched for over the whole image, because no previous seam fit.
+      // Accumulates across frames and isn't reset by clear.
+      int full_searches = 0;
+
+      void clear() {
+         column_seams.clear();
+         row_seams.clear();
+      }
+   };
+
    QImage resize(const QImage image, QSize size);
+   QImage resize(const QImage image, QSize size, SeamHistory* history, int band);
    QImage calculate_energy_image(const QImage image);
 }
 
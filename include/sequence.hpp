@@ -0,0 +1,56 @@
+#ifndef SEQUENCE_HPP
+#define SEQUENCE_HPP
+
+#include <QtCore/QSize>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+namespace seamcarve {
+
+   /**
+    * Settings for resizing an image sequence, e.g. the frames of a video.
+    */
+   struct SequenceConfig {
+      QStringList input_paths;
+      QString output_dir;
+
+      // Target frame size, a dimension that isn't positive is left unchanged.
+      QSize size;
+
+      // Columns either side of the previous frame's seams to search.
+      int band = 8;
+
+      // Mean per pixel gray difference, between 0 and 1, above which two frames
+      // are considered a scene change and the seams are searched for from scratch.
+      float scene_change_threshold = 0.1f;
+   };
+
+   /**
+    * Summary of a sequence run.
+    */
+   struct SequenceStats {
+      // frames successfully written.
+      int frames = 0;
+      int failed_reads = 0;
+      int failed_writes = 0;
+      int scene_changes = 0;
+
+      // seams searched for over the whole frame rather than near the previous frame's.
+      int full_searches = 0;
+      double seconds = 0.0;
+      double fps = 0.0;
+   };
+
+   /**
+    * Resize every frame of the sequence to config.size, writing them to
+    * config.output_dir, which must exist, under their original file names.
+    * Decoding, scene change detection, carving, and encoding each run in their
+    * own thread so frames stream through the stages concurrently.
+    * Energy is calculated within the carving stage rather than a stage of its own,
+    * since each seam's energies depend on the image left by removing the seam before it.
+    */
+   SequenceStats resize_sequence(const SequenceConfig& config);
+
+}
+
+#endif
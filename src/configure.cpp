@@ -12,7 +12,12 @@ namespace seamcarve  {
 
       desc.add_options()
           ("help,h", "This Help message")
-          ("image_path,i", opts::value<std::string>(), "Image Path");
+          ("image_path,i", opts::value<std::string>(), "Image Path")
+          ("input_dir,d", opts::value<std::string>(), "Frame directory to resize as a sequence")
+          ("output_dir,o", opts::value<std::string>(), "Directory to write resized frames, required with input_dir")
+          ("width", opts::value<int>()->default_value(0), "Sequence frame width, 0 keeps the original")
+          ("height", opts::value<int>()->default_value(0), "Sequence frame height, 0 keeps the original")
+          ("band", opts::value<int>()->default_value(8), "Columns around the previous frame's seams to search");
 
       return desc;
    }
@@ -41,6 +46,26 @@ namespace seamcarve  {
       config.image_path = vmap.count("image_path")
                           ? vmap["image_path"].as<std::string>()
                           : "";
+      config.input_dir = vmap.count("input_dir")
+                         ? vmap["input_dir"].as<std::string>()
+                         : "";
+      config.output_dir = vmap.count("output_dir")
+                          ? vmap["output_dir"].as<std::string>()
+                          : "";
+      config.width      = vmap["width"].as<int>();
+      config.height     = vmap["height"].as<int>();
+      config.band       = vmap["band"].as<int>();
+
+      if (config.band < 0) {
+         std::cerr << "--band must not be negative" << std::endl;
+         return boost::optional<Config>();
+      }
+
+      // frames are written under their original names, so never default to a directory.
+      if (!config.input_dir.empty() && config.output_dir.empty()) {
+         std::cerr << "--output_dir is required with --input_dir" << std::endl;
+         return boost::optional<Config>();
+      }
 
       return boost::optional<Config>(config);
    }
@@ -1,8 +1,11 @@
 #include "configure.hpp"
 #include "seamcarve.hpp"
 #include "seamcarveui.hpp" // Generated UI.
+#include "sequence.hpp"
 #include "ui/mainWindow.hpp"
 
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
 #include <iostream>
 #include <string>
 
@@ -15,20 +18,83 @@ seamcarve::ui::MainWindow* create_window() {
    return window;
 }
 
-int main(int argc, char const* argv[]) {
+/*
+ * Resize every frame in the configured input directory without showing the UI.
+ * Returns nonzero when there was nothing to resize or any frame failed.
+ */
+int run_sequence(int argc, char const* argv[], const seamcarve::Config& config) {
    using namespace seamcarve;
 
-   // UI setup
-   QApplication app(argc, (char**) argv);
-   auto window = create_window();
-   window->show();
+   // needed for Qt's image format plugins.
+   QCoreApplication app(argc, (char**) argv);
+
+   QDir input_dir(QString::fromStdString(config.input_dir));
+   QDir output_dir(QString::fromStdString(config.output_dir));
+   QStringList filters = {"*.png", "*.jpg"};
+
+   if (!input_dir.exists()) {
+      std::cerr << "Input directory " << config.input_dir << " does not exist" << std::endl;
+      return 1;
+   }
+
+   if (!QDir().mkpath(output_dir.path())) {
+      std::cerr << "Unable to create output directory " << config.output_dir << std::endl;
+      return 1;
+   }
+
+   // frames keep their names, so writing into the input directory would replace them.
+   if (input_dir.canonicalPath() == output_dir.canonicalPath()) {
+      std::cerr << "Output directory must differ from the input directory" << std::endl;
+      return 1;
+   }
+
+   SequenceConfig sequence;
+   for (const QString& name : input_dir.entryList(filters, QDir::Files, QDir::Name)) {
+      sequence.input_paths << input_dir.filePath(name);
+   }
+   sequence.output_dir = output_dir.path();
+   sequence.size       = QSize(config.width, config.height);
+   sequence.band       = config.band;
+
+   if (sequence.input_paths.isEmpty()) {
+      std::cerr << "No frames found in " << config.input_dir << std::endl;
+      return 1;
+   }
+
+   SequenceStats stats = resize_sequence(sequence);
+
+   std::cout << "Resized " << stats.frames << " frames in " << stats.seconds << "s ("
+             << stats.fps << " fps, " << stats.scene_changes << " scene changes, "
+             << stats.full_searches << " full seam searches)" << std::endl;
+
+   if (stats.failed_reads > 0 || stats.failed_writes > 0) {
+      std::cerr << stats.failed_reads << " frames could not be read, "
+                << stats.failed_writes << " could not be written" << std::endl;
+      return 1;
+   }
+
+   return 0;
+}
 
-   // Get cmdline config, to potentially set image.
+int main(int argc, char const* argv[]) {
+   using namespace seamcarve;
+
+   // Get cmdline config, to potentially set image or resize a sequence.
    boost::optional<Config> opt_config = create_config(argc, argv);
    if (!opt_config) {
       return 1;
    }
    Config config = opt_config.get();
+
+   if (!config.input_dir.empty()) {
+      return run_sequence(argc, argv, config);
+   }
+
+   // UI setup
+   QApplication app(argc, (char**) argv);
+   auto window = create_window();
+   window->show();
+
    QString filename = QString::fromStdString(config.image_path);
 
    emit window->signal_image_from_cmdline(filename);
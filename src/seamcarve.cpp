@@ -9,8 +9,8 @@
    using std::max;
 #include <cmath>
    using std::fabs;
-#include <deque>
-   using std::deque;
+#include <cstdint>
+   using std::uint8_t;
 #include <functional>
    using std::bind;
    using std::function;
@@ -22,18 +22,52 @@
    using std::vector;
 
 #include <iostream>
+#include <limits>
 
 namespace seamcarve {
 
    /**********************INTERNAL DECLARATIONS***********************/
 
-   QImage remove_rows(const QImage image, int num);
+   /*
+    * Which neighbor in the row above each pixel's cheapest seam came from,
+    * packed 2 bits per pixel: 0 up-left, 1 up, 2 up-right.
+    * Recorded while calculating min energies so a seam can be traced without
+    * keeping or re-scanning the cumulative energy table.
+    */
+   struct SeamDirections {
+      SeamDirections(int num_pixels) : bits((num_pixels + 3) / 4, 0) {}
+
+      void set(int pixel_index, int direction) {
+         uint8_t& byte = bits[pixel_index >> 2];
+         int shift     = (pixel_index & 3) * 2;
+         byte = (byte & ~(3 << shift)) | (direction << shift);
+      }
+
+      // column offset, -1, 0, or 1, of the pixel above in the seam.
+      int offset(int pixel_index) const {
+         int shift = (pixel_index & 3) * 2;
+         return ((bits[pixel_index >> 2] >> shift) & 3) - 1;
+      }
+
+      vector<uint8_t> bits;
+   };
 
-   QImage remove_columns(const QImage image, int num);
+   QImage remove_rows(const QImage image, int num, vector<vector<int>>* seams, int band,
+                      int* full_searches);
 
-   float* calculate_min_energies(const QImage image, float* energies);
+   QImage remove_columns(const QImage image, int num, vector<vector<int>>* seams, int band,
+                         int* full_searches);
 
-   deque<int> find_column_seam(float* energies, int width, int height);
+   const vector<int>* find_guide_seam(vector<vector<int>>* seams, int index, int width, int height);
+
+   float* calculate_band_energies(const QImage image, const vector<int>& guide, int band);
+
+   int calculate_min_energies(const QImage image, float* energies, SeamDirections& directions,
+                              float* rows);
+
+   void find_column_seam(const SeamDirections& directions, int end_col, int width, int height, int* seam);
+
+   vector<int> seam_columns(const vector<int>& seam, int width);
 
    float calculate_pixel_energy(PixelArgs& pargs);
 
@@ -52,16 +86,34 @@ namespace seamcarve {
     * this ordering is mathematically calculated.
     */
    QImage resize(const QImage image, QSize size) {
+      return resize(image, size, NULL, 0);
+   }
+
+   /*
+    * Same as above, but seams are searched for within band pixels of the
+    * seams already in history, when they fit this image.  Seams that don't
+    * fit, or an empty history, fall back to searching the whole image.
+    * The seams removed from this image replace the ones in history.
+    */
+   QImage resize(const QImage image, QSize size, SeamHistory* history, int band) {
       QImage result = image;
       int width_diff = size.width() - image.width();
       int height_diff = size.height() - image.height();
 
+      vector<vector<int>>* column_seams = history ? &history->column_seams : NULL;
+      vector<vector<int>>* row_seams    = history ? &history->row_seams : NULL;
+      int* full_searches                = history ? &history->full_searches : NULL;
+
       if (width_diff < 0) {
-         result = remove_columns(result, -width_diff);
+         result = remove_columns(result, -width_diff, column_seams, band, full_searches);
+      } else if (column_seams) {
+         column_seams->clear();
       }
 
       if (height_diff < 0) {
-         result = remove_rows(result, -height_diff);
+         result = remove_rows(result, -height_diff, row_seams, band, full_searches);
+      } else if (row_seams) {
+         row_seams->clear();
       }
 
       return result;
@@ -85,7 +137,7 @@ namespace seamcarve {
       QImage energy_image = create_img(image, transform);
 
       // free memory
-      delete energies;
+      delete[] energies;
 
       return energy_image;
    }
@@ -96,11 +148,13 @@ namespace seamcarve {
     * Remove row by removing columns of the transposed image.
     * This approach is slower, but cleaner.
     */
-   QImage remove_rows(const QImage image, int num) {
+   QImage remove_rows(const QImage image, int num, vector<vector<int>>* seams, int band,
+                      int* full_searches) {
       QTransform rotate_forward  = QTransform().rotate(90);
       QTransform rotate_backward = QTransform().rotate(-90);
 
-      QImage rotated_image = remove_columns(image.transformed(rotate_forward), num);
+      QImage rotated_image = remove_columns(image.transformed(rotate_forward), num, seams, band,
+                                            full_searches);
       return rotated_image.transformed(rotate_backward);
    }
 
@@ -117,10 +171,21 @@ namespace seamcarve {
     *
     * Flow
     *   Eng + Seam -> Eng_small -> Eng_diff_small -> Seam_small
+    *
+    * When seams holds the seams of a previous, similar frame, only the pixels
+    * within band of the matching seam get an energy, the rest are off limits.
+    * On return seams holds the seams removed from this image, and full_searches
+    * has been incremented for each seam that had no previous seam to search near.
     */
-   QImage remove_columns(const QImage image, int num) {
+   QImage remove_columns(const QImage image, int num, vector<vector<int>>* seams, int band,
+                         int* full_searches) {
       QRgb* image_data = (QRgb*) image.bits();
-      deque<int> seam;
+      vector<vector<int>> found_seams;
+
+      // sized for the first, largest, image and reused for each seam.
+      SeamDirections directions(image.width() * image.height());
+      vector<float> min_energy_rows(2 * image.width());
+      vector<int> seam(image.height());
 
       for (int i = 0; i < num; i++) {
          int width      = image.width() - i;
@@ -130,105 +195,148 @@ namespace seamcarve {
          // create an image used for iteration.  We can't simply use the image above as it is also const.
          // removing the constness, we would incur a copy, when we access the underlying bits.
          const QImage prev_image = QImage((uchar*) image_data, width, height, image.format());
-         float* energies         = map(image, calculate_pixel_energy); // Per pixel energy
-         float* min_energies     = calculate_min_energies(prev_image, energies);
+         const vector<int>* guide = find_guide_seam(seams, i, width, height);
+         if (!guide && full_searches) (*full_searches)++;
 
-         // traverse the grid of prev_pixels and find the seam.
-         seam = find_column_seam(min_energies, width, height);
+         // Per pixel energy, restricted to the band around the guide seam if there is one.
+         float* energies     = guide ? calculate_band_energies(prev_image, *guide, band)
+                                     : map(prev_image, calculate_pixel_energy);
+         int seam_end        = calculate_min_energies(prev_image, energies, directions,
+                                                      min_energy_rows.data());
+
+         // follow the directions back up from the cheapest pixel in the last row.
+         find_column_seam(directions, seam_end, width, height, seam.data());
+         if (seams) found_seams.push_back(seam_columns(seam, width));
 
          // actually remove seam pixels
          QRgb* prev_image_data = (QRgb*) prev_image.bits();
          image_data            = prune(prev_image_data, seam, num_pixels);
 
          // only delete image data that was copied from the origial image.
-         if (i > 0) delete prev_image_data;
+         if (i > 0) delete[] prev_image_data;
 
          // free memory
-         delete[] min_energies;
-         delete energies;
+         delete[] energies;
       }
 
+      if (seams) seams->swap(found_seams);
+
       return QImage((uchar*) image_data, image.width() - num, image.height(),
                     image.format(), image_cleanup_handler, image_data);
    }
 
    /*
-    * Determine min energy of the current pixel based on looking at previous neighbor pixels
+    * The previously found seam to search around for the index'th seam, or NULL
+    * when there is none or it doesn't fit the current image.
+    */
+   const vector<int>* find_guide_seam(vector<vector<int>>* seams, int index, int width, int height) {
+      if (!seams || index >= (int) seams->size()) return NULL;
+
+      const vector<int>& guide = (*seams)[index];
+      if ((int) guide.size() != height) return NULL;
+
+      for (int col : guide) {
+         if (col < 0 || col >= width) return NULL;
+      }
+
+      return &guide;
+   }
+
+   /*
+    * Per pixel energy for pixels within band columns of the guide seam.
+    * Every other pixel is given infinite energy so no seam passes through it.
+    */
+   float* calculate_band_energies(const QImage image, const vector<int>& guide, int band) {
+      PixelArgs pargs = PixelArgs(image);
+
+      float* energies = new float[pargs.num_pixels];
+      std::fill(energies, energies + pargs.num_pixels, std::numeric_limits<float>::infinity());
+
+      for (int row = 0; row < pargs.height; row++) {
+         int col_low  = max(0, guide[row] - band);
+         int col_high = min(pargs.width - 1, guide[row] + band);
+
+         for (int col = col_low; col <= col_high; col++) {
+            pargs.set_pixel(col, row);
+            energies[pargs.pixel_index] = calculate_pixel_energy(pargs);
+         }
+      }
+
+      return energies;
+   }
+
+   /*
+    * Determine min energy of the current pixel based on looking at previous neighbor pixels,
+    * recording which neighbor was chosen in directions.
+    * Only the previous and current rows of min energies are kept, in rows,
+    * which holds at least 2 * width entries.
+    * Returns the column of the least energetic pixel in the last row, where the seam ends.
     */
-   float* calculate_min_energies(const QImage image, float* energies) {
-      int width      = image.width();
-      int height     = image.height();
-      int num_pixels = width * height;
+   int calculate_min_energies(const QImage image, float* energies, SeamDirections& directions,
+                              float* rows) {
+      int width  = image.width();
+      int height = image.height();
+
+      auto row_energies = [&](int row) {
+         return rows + ((row % 2) * width);
+      };
+
+      // first row of diff should just be energy of pixel.
+      std::copy(energies, energies + width, row_energies(0));
 
-      // results
-      float* min_energies = new float[num_pixels];
+      for (int row = 1; row < height; row++) {
+        float* prev_min_energies = row_energies(row - 1);
+        float* cur_min_energies  = row_energies(row);
 
-      for (int row = 0; row < height; row++) {
         for (int col = 0; col < width; col++) {
           int pixel_index = (row * width) + col;
 
-          // first row of diff should just be energy of pixel.
-          if (row == 0) {
-            min_energies[pixel_index] = energies[pixel_index];
-            continue;
-          }
-
           float min_prev_energy = std::numeric_limits<float>::max();
-          for (int prev_col = col - 1; prev_col <= col + 1; prev_col++) {
-             if (prev_col < 0 || prev_col >= width) continue;
-
-             int prev_pixel_index = (row - 1) * width + prev_col;
-             int prev_energy      = energies[prev_pixel_index];
+          int direction         = 1;
+          for (int prev_col = max(0, col - 1); prev_col <= min(width - 1, col + 1); prev_col++) {
+             float prev_energy = prev_min_energies[prev_col];
 
              if (prev_energy <= min_prev_energy) {
                 min_prev_energy = prev_energy;
+                direction       = prev_col - col + 1;
              }
           }
 
-          min_energies[pixel_index] = energies[pixel_index] + min_prev_energy;
+          cur_min_energies[col] = energies[pixel_index] + min_prev_energy;
+          directions.set(pixel_index, direction);
         }
       }
 
-      return min_energies;
+      float* last_min_energies = row_energies(height - 1);
+      return min_element(last_min_energies, last_min_energies + width) - last_min_energies;
    }
 
    /*
-    * Walks the NxM energy_diff grid to find the already calculated seam.
+    * Walks the recorded directions up from end_col in the last row, writing the
+    * pixel index removed from each row into seam, which holds height entries.
     */
-   deque<int> find_column_seam(float* min_energies, int width, int height) {
-      deque<int> seam;
-
-      int min_col = 0;
+   void find_column_seam(const SeamDirections& directions, int end_col, int width, int height, int* seam) {
+      int col = end_col;
 
       for (int row = (height - 1); row >= 0; row--)  {
-        int col;
-        int col_high;
-
-        // for the last row we need to search all columns, for others just neighbors
-        if (row == height - 1) {
-          col      = 0;
-          col_high = width - 1;
-        } else {
-          col      = max(0, min_col - 1);
-          col_high = min(width - 1, min_col + 1);
-        }
-
-        int min_col_energy = std::numeric_limits<float>::max();
-
-        for (; col <= col_high; col++) {
-          int index = (width * row) + col;
-          float energy = min_energies[index];
+        int index = (width * row) + col;
+        seam[row] = index;
+        col += directions.offset(index);
+      }
+   }
 
-          if (energy < min_col_energy) {
-            min_col_energy = energy;
-            min_col = col;
-          }
-        }
+   /*
+    * Converts a seam of pixel indexes into the column removed from each row.
+    */
+   vector<int> seam_columns(const vector<int>& seam, int width) {
+      vector<int> columns;
+      columns.reserve(seam.size());
 
-        seam.push_front((width * row) + min_col);
+      for (int index : seam) {
+         columns.push_back(index % width);
       }
 
-      return seam;
+      return columns;
    }
 
    /*
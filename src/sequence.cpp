@@ -0,0 +1,231 @@
+#include "sequence.hpp"
+#include "seamcarve.hpp"
+
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtGui/QImage>
+#include <boost/optional.hpp>
+#include <algorithm>
+   using std::max;
+#include <chrono>
+#include <condition_variable>
+   using std::condition_variable;
+#include <cstdlib>
+   using std::abs;
+#include <deque>
+   using std::deque;
+#include <iostream>
+#include <mutex>
+   using std::mutex;
+   using std::unique_lock;
+#include <thread>
+   using std::thread;
+
+namespace seamcarve {
+
+   /**********************INTERNAL DECLARATIONS***********************/
+
+   /*
+    * A frame as it moves through the pipeline.
+    */
+   struct Frame {
+      QString name;
+      QImage image;
+      bool scene_change;
+   };
+
+   /*
+    * Bounded queue connecting two pipeline stages.
+    * Producers block while it is full, consumers while it is empty.
+    * Once closed and drained, pop returns nothing.
+    */
+   template <typename T>
+   class Channel {
+   public:
+      explicit Channel(size_t capacity) : capacity(capacity) {}
+
+      void push(T item) {
+         unique_lock<mutex> lock(items_mutex);
+         not_full.wait(lock, [this] { return items.size() < capacity; });
+         items.push_back(std::move(item));
+         not_empty.notify_one();
+      }
+
+      boost::optional<T> pop() {
+         unique_lock<mutex> lock(items_mutex);
+         not_empty.wait(lock, [this] { return !items.empty() || closed; });
+         if (items.empty()) return boost::optional<T>();
+
+         T item = std::move(items.front());
+         items.pop_front();
+         not_full.notify_one();
+         return boost::optional<T>(std::move(item));
+      }
+
+      void close() {
+         unique_lock<mutex> lock(items_mutex);
+         closed = true;
+         not_empty.notify_all();
+      }
+
+   private:
+      size_t capacity;
+      bool closed = false;
+      deque<T> items;
+      mutex items_mutex;
+      condition_variable not_full;
+      condition_variable not_empty;
+   };
+
+   const size_t CHANNEL_CAPACITY = 4;
+
+   void decode_frames(const SequenceConfig& config, Channel<Frame>& output, SequenceStats& stats);
+
+   void detect_scene_changes(const SequenceConfig& config, Channel<Frame>& input, Channel<Frame>& output);
+
+   void carve_frames(const SequenceConfig& config, Channel<Frame>& input, Channel<Frame>& output,
+                     SequenceStats& stats);
+
+   void encode_frames(const SequenceConfig& config, Channel<Frame>& input, SequenceStats& stats);
+
+   float frame_difference(const QImage previous, const QImage current);
+
+   /**********************DEFINITIONS***********************/
+
+   SequenceStats resize_sequence(const SequenceConfig& config) {
+      SequenceStats stats;
+
+      Channel<Frame> decoded(CHANNEL_CAPACITY);
+      Channel<Frame> analysed(CHANNEL_CAPACITY);
+      Channel<Frame> carved(CHANNEL_CAPACITY);
+
+      auto start = std::chrono::steady_clock::now();
+
+      // each stage writes to separate fields of stats, so no locking is needed.
+      thread decoder(decode_frames, std::cref(config), std::ref(decoded), std::ref(stats));
+      thread detector(detect_scene_changes, std::cref(config), std::ref(decoded), std::ref(analysed));
+      thread carver(carve_frames, std::cref(config), std::ref(analysed), std::ref(carved), std::ref(stats));
+      thread encoder(encode_frames, std::cref(config), std::ref(carved), std::ref(stats));
+
+      decoder.join();
+      detector.join();
+      carver.join();
+      encoder.join();
+
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      stats.seconds = elapsed.count();
+      stats.fps     = stats.seconds > 0.0 ? stats.frames / stats.seconds : 0.0;
+
+      return stats;
+   }
+
+   /**********************INTERNAL DEFINITIONS***********************/
+
+   /*
+    * Loads each input frame in order.  Frames that can't be read are skipped.
+    */
+   void decode_frames(const SequenceConfig& config, Channel<Frame>& output, SequenceStats& stats) {
+      for (const QString& path : config.input_paths) {
+         QImage image(path);
+
+         if (image.isNull()) {
+            std::cerr << "Unable to read frame " << path.toStdString() << std::endl;
+            stats.failed_reads++;
+            continue;
+         }
+
+         // seam carving works directly on 32 bit pixel data.
+         if (image.format() != QImage::Format_ARGB32) {
+            image = image.convertToFormat(QImage::Format_ARGB32);
+         }
+
+         output.push(Frame{QFileInfo(path).fileName(), image, false});
+      }
+
+      output.close();
+   }
+
+   /*
+    * Marks frames that differ too much from the one before them, so their seams
+    * are searched for over the whole image rather than near the previous seams.
+    */
+   void detect_scene_changes(const SequenceConfig& config, Channel<Frame>& input, Channel<Frame>& output) {
+      QImage previous;
+
+      while (boost::optional<Frame> frame = input.pop()) {
+         frame->scene_change = previous.isNull()
+                               || previous.size() != frame->image.size()
+                               || frame_difference(previous, frame->image) > config.scene_change_threshold;
+
+         previous = frame->image;
+         output.push(std::move(frame.get()));
+      }
+
+      output.close();
+   }
+
+   /*
+    * Resizes each frame, carrying seams over from one frame to the next.
+    * Frames depend on their predecessor's seams, so carving stays in one thread.
+    */
+   void carve_frames(const SequenceConfig& config, Channel<Frame>& input, Channel<Frame>& output,
+                     SequenceStats& stats) {
+      SeamHistory history;
+
+      while (boost::optional<Frame> frame = input.pop()) {
+         if (frame->scene_change) {
+            history.clear();
+            stats.scene_changes++;
+         }
+
+         QSize size(config.size.width() > 0 ? config.size.width() : frame->image.width(),
+                    config.size.height() > 0 ? config.size.height() : frame->image.height());
+
+         frame->image = resize(frame->image, size, &history, config.band);
+         output.push(std::move(frame.get()));
+      }
+
+      stats.full_searches = history.full_searches;
+      output.close();
+   }
+
+   /*
+    * Writes each carved frame to the output directory.
+    */
+   void encode_frames(const SequenceConfig& config, Channel<Frame>& input, SequenceStats& stats) {
+      QDir output_dir(config.output_dir);
+
+      while (boost::optional<Frame> frame = input.pop()) {
+         QString path = output_dir.filePath(frame->name);
+
+         if (!frame->image.save(path)) {
+            std::cerr << "Unable to write frame " << path.toStdString() << std::endl;
+            stats.failed_writes++;
+            continue;
+         }
+
+         stats.frames++;
+      }
+   }
+
+   /*
+    * Mean gray level difference between two equally sized frames, between 0 and 1.
+    * Only a grid of roughly 64x64 pixels is compared, which is plenty to spot a cut.
+    */
+   float frame_difference(const QImage previous, const QImage current) {
+      int x_step = max(1, current.width() / 64);
+      int y_step = max(1, current.height() / 64);
+
+      long total   = 0;
+      long samples = 0;
+      for (int y = 0; y < current.height(); y += y_step) {
+         for (int x = 0; x < current.width(); x += x_step) {
+            total += abs(qGray(previous.pixel(x, y)) - qGray(current.pixel(x, y)));
+            samples++;
+         }
+      }
+
+      return samples > 0 ? total / (255.0f * samples) : 0.0f;
+   }
+
+}
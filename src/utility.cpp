@@ -19,7 +19,7 @@ namespace seamcarve {
 
    // used a callback in QIMage to delete the memory buffer. 
    void image_cleanup_handler(void *data) {
-      delete ((QRgb*) data);
+      delete[] ((QRgb*) data);
    }
 
 }